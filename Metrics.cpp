@@ -0,0 +1,102 @@
+#include "Metrics.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+using std::cout;
+using std::endl;
+
+SimulationMetrics::SimulationMetrics( int numBuckets, int ticksPerBucket, double hoursPerTick, int maxQueueSize, int numWaitBins, double waitBinHours )
+    : buckets( std::max( numBuckets, 1 ) ), queueSizeCounts( std::max( maxQueueSize, 0 ) + 1, 0 ), timeToChargerCounts( std::max( numWaitBins, 1 ), 0 ),
+      unfinishedWaitCounts( std::max( numWaitBins, 1 ), 0 ),
+      ticksPerBucket( std::max( ticksPerBucket, 1 ) ), hoursPerTick( hoursPerTick ), waitBinHours( waitBinHours )
+{
+
+}
+
+void SimulationMetrics::recordTick( double chargerBusyHours, int chargersInService, int waitingQueueSize )
+{
+    // any ticks past the expected duration are counted in the last bucket
+    TimeBucket & bucket = buckets[std::min<int>( tickNum / ticksPerBucket, buckets.size() - 1 )];
+    bucket.chargerBusyHours += chargerBusyHours;
+    bucket.chargerServiceHours += chargersInService * hoursPerTick;
+    bucket.waitingSum += waitingQueueSize;
+    bucket.maxWaiting = std::max( bucket.maxWaiting, waitingQueueSize );
+    ++bucket.ticks;
+
+    ++queueSizeCounts[std::min<int>( waitingQueueSize, queueSizeCounts.size() - 1 )];
+    ++tickNum;
+}
+
+void SimulationMetrics::recordTimeToCharger( double hoursWaited )
+{
+    ++timeToChargerCounts[std::min<int>( hoursWaited / waitBinHours, timeToChargerCounts.size() - 1 )];
+}
+
+void SimulationMetrics::recordUnfinishedWait( double hoursWaited )
+{
+    ++unfinishedWaitCounts[std::min<int>( hoursWaited / waitBinHours, unfinishedWaitCounts.size() - 1 )];
+}
+
+double SimulationMetrics::getChargerUtilization( int bucket ) const
+{
+    if( buckets[bucket].chargerServiceHours <= 0.0 )
+        return 0.0;
+
+    return buckets[bucket].chargerBusyHours / buckets[bucket].chargerServiceHours;
+}
+
+double SimulationMetrics::getMeanWaitingQueue( int bucket ) const
+{
+    if( buckets[bucket].ticks == 0 )
+        return 0.0;
+
+    return static_cast<double>( buckets[bucket].waitingSum ) / buckets[bucket].ticks;
+}
+
+void SimulationMetrics::display() const
+{
+    double hoursPerBucket = ticksPerBucket * hoursPerTick;
+    int peakBucket = 0;
+
+    cout << endl;
+    cout << "Time (hr)       | Charger Util. |  Avg. Queue |   Max Queue |" << endl;
+    cout << "-------------------------------------------------------------" << endl;
+    for( size_t i = 0; i < buckets.size(); ++i )
+    {
+        if( getMeanWaitingQueue( i ) > getMeanWaitingQueue( peakBucket ) )
+            peakBucket = i;
+
+        cout << std::fixed << std::setprecision(2) << std::setw(6) << i * hoursPerBucket << " - " << std::setw(6) << ( i + 1 ) * hoursPerBucket << " |" 
+             << std::setw(12) << std::setprecision(1) << getChargerUtilization( i ) * 100 << "% |" 
+             << std::setw(12) << std::setprecision(2) << getMeanWaitingQueue( i ) << " |" 
+             << std::setw(12) << getMaxWaitingQueue( i ) << " |" << endl;
+    }
+    cout << "Peak contention: " << std::setprecision(2) << peakBucket * hoursPerBucket << " - " << ( peakBucket + 1 ) * hoursPerBucket 
+         << " hr ( avg. queue " << getMeanWaitingQueue( peakBucket ) << " )" << endl;
+
+    cout << endl;
+    cout << "Waiting Queue Size | Fraction of Time |" << endl;
+    cout << "---------------------------------------" << endl;
+    for( size_t i = 0; i < queueSizeCounts.size(); ++i )
+    {
+        if( queueSizeCounts[i] == 0 )
+            continue;
+
+        cout << std::setw(18) << ( i == queueSizeCounts.size() - 1 ? std::to_string( i ) + "+" : std::to_string( i ) ) << " |" 
+             << std::setw(16) << std::setprecision(4) << static_cast<double>( queueSizeCounts[i] ) / std::max( tickNum, 1 ) << " |" << endl;
+    }
+
+    cout << endl;
+    cout << "Time to Charger (hr) |       Count | Still Waiting |" << endl;
+    cout << "-----------------------------------------------------" << endl;
+    for( size_t i = 0; i < timeToChargerCounts.size(); ++i )
+    {
+        cout << std::setprecision(2) << std::setw(11) << i * waitBinHours;
+        if( i == timeToChargerCounts.size() - 1 )
+            cout << " +       |";
+        else
+            cout << " - " << std::setw(6) << ( i + 1 ) * waitBinHours << " |";
+        cout << std::setw(12) << timeToChargerCounts[i] << " |" << std::setw(14) << unfinishedWaitCounts[i] << " |" << endl;
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <vector>
+
+using std::vector;
+
+/**
+ * fixed memory counters of charger utilization, waiting queue length and time to charger collected as the simulation runs
+ */
+class SimulationMetrics
+{
+    public:
+        /**
+         * @param numBuckets number of time buckets the simulation is divided into
+         * @param ticksPerBucket number of ticks of the simulation in each time bucket
+         * @param hoursPerTick simulated hours in each tick
+         * @param maxQueueSize largest waiting queue size to count individually, larger sizes are counted with it
+         * @param numWaitBins number of time to charger histogram bins, longer waits are counted in the last bin
+         * @param waitBinHours width in hours of each time to charger histogram bin
+         */
+        SimulationMetrics( int numBuckets, int ticksPerBucket, double hoursPerTick, int maxQueueSize, int numWaitBins, double waitBinHours );
+
+        /**
+         * @brief record the state of the chargers and waiting queue at the end of a tick
+         * @param chargerBusyHours total hours across all chargers spent charging VTOLs this tick
+         * @param chargersInService number of chargers in service during the tick
+         * @param waitingQueueSize number of VTOLs still waiting for a charger at the end of the tick
+         */
+        void recordTick( double chargerBusyHours, int chargersInService, int waitingQueueSize );
+
+        /**
+         * @brief record how long a VTOL waited before being moved to a charger
+         * @param hoursWaited hours between the VTOL running out of charge and reaching a charger
+         */
+        void recordTimeToCharger( double hoursWaited );
+
+        /**
+         * @brief record a wait that ended without reaching a charger, because the run ended or the VTOL left service
+         * @param hoursWaited hours the VTOL had waited so far, a lower bound on its time to charger
+         */
+        void recordUnfinishedWait( double hoursWaited );
+
+        /**
+         * @brief display the per bucket, waiting queue and time to charger tables
+         */
+        void display() const;
+
+        int getNumBuckets() const { return buckets.size(); }
+        double getChargerUtilization( int bucket ) const;
+        double getMeanWaitingQueue( int bucket ) const;
+        int getMaxWaitingQueue( int bucket ) const { return buckets[bucket].maxWaiting; }
+        long long getWaitingQueueCount( int size ) const { return queueSizeCounts[size]; }
+        long long getTimeToChargerCount( int bin ) const { return timeToChargerCounts[bin]; }
+        long long getUnfinishedWaitCount( int bin ) const { return unfinishedWaitCounts[bin]; }
+        int getNumWaitBins() const { return timeToChargerCounts.size(); }
+    private:
+        struct TimeBucket
+        {
+            double chargerBusyHours = 0.0;
+            double chargerServiceHours = 0.0;
+            long long waitingSum = 0;
+            int maxWaiting = 0;
+            int ticks = 0;
+        };
+
+        vector<TimeBucket> buckets;
+        vector<long long> queueSizeCounts;      // number of ticks ending with each waiting queue size
+        vector<long long> timeToChargerCounts;  // number of VTOLs reaching a charger after each range of waiting time
+        vector<long long> unfinishedWaitCounts; // number of waits cut short by the end of the run or leaving service after each range of waiting time
+        int ticksPerBucket;
+        double hoursPerTick;
+        double waitBinHours;
+        int tickNum = 0;
+};
+
+#endif
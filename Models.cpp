@@ -1,6 +1,7 @@
 #include "Models.h"
 #include "Utils.h"
 #include <iostream>
+#include <strings.h>
 
 VTOL::VTOL( VTOLMake make ) : state( FLYING ), make( make )
 {
@@ -24,6 +25,37 @@ VTOL::VTOL( VTOLMake make ) : state( FLYING ), make( make )
     }
 }
 
+const char * getMakeName( VTOLMake make )
+{
+    switch( make )
+    {
+        case ALPHA:
+            return "Alpha";
+        case BETA:
+            return "Beta";
+        case CHARLIE:
+            return "Charlie";
+        case DELTA:
+            return "Delta";
+        case ECHO:
+            return "Echo";
+    }
+    return "";
+}
+
+bool parseMake( const char * name, VTOLMake & make )
+{
+    for( int i = 0; i < NUM_MAKES; ++i )
+    {
+        if( strcasecmp( name, getMakeName( static_cast<VTOLMake>( i ) ) ) == 0 )
+        {
+            make = static_cast<VTOLMake>( i );
+            return true;
+        }
+    }
+    return false;
+}
+
 void VTOL::Init( int speed, int batteryCapacity, double chargeTime, double kwhPerMile, int passengerCapacity, double faultProbability )
 {
     this->speed = speed;
@@ -70,6 +102,7 @@ double VTOL::updateVTOL( double dTime, double faultRoll )
             case FLYING:
                 setState( WAITING );
                 timeToStateChange = UNLIMITED;
+                waitStartTime = timeWaiting;
                 timeWaiting += timeInStateThisTick;
                 break;
             case CHARGING:
@@ -169,7 +202,21 @@ bool VTOLQueue::empty()
 
 bool VTOLQueue::full()
 {
-    return capacity != UNLIMITED && q.size() == capacity;
+    return capacity != UNLIMITED && static_cast<int>( q.size() ) >= capacity;
+}
+
+VTOL * VTOLQueue::removeMake( VTOLMake make )
+{
+    for( deque<VTOL *>::iterator cur = q.begin(); cur != q.end(); ++cur )
+    {
+        if( ( *cur )->getMake() == make )
+        {
+            VTOL * VTOL = *cur;
+            q.erase( cur );
+            return VTOL;
+        }
+    }
+    return nullptr;
 }
 
 double VTOLQueue::getFaultRoll()
@@ -180,10 +227,16 @@ double VTOLQueue::getFaultRoll()
     }
     
     std::uniform_real_distribution<double> distribution( 0.0, 1.0 );
-    return distribution( *generator );
+    double roll = distribution( *generator );
+    if( trace )
+    {
+        roll = trace->traceFaultRoll( roll );
+    }
+    return roll;
 }
 
 void VTOLQueue::initGenerator()
 {
-    generator = new std::default_random_engine( clock() );
+    std::seed_seq seq{ randSeed };
+    generator = new std::default_random_engine( seq );
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include <cmath>
 #include <random>
 #include <thread>
+#include "Trace.h"
 
 using std::vector;
 using std::deque;
@@ -29,6 +30,22 @@ enum VTOLMake
     ECHO = 4
 };
 
+#define NUM_MAKES 5
+
+/**
+ * @brief get the display name of a make of VTOL
+ * @param make the make to retrieve the name of
+ */
+const char * getMakeName( VTOLMake make );
+
+/**
+ * @brief find the make matching a name, ignoring case
+ * @param name the name to match
+ * @param make set to the matching make if one is found
+ * @return true if a make matched the name
+ */
+bool parseMake( const char * name, VTOLMake & make );
+
 class VTOL
 {
     public:
@@ -52,6 +69,7 @@ class VTOL
         double getTimeInFlight() const { return timeFlying; }
         double getTimeWaiting() const { return timeWaiting; }
         double getTimeCharging() const { return timeCharging; }
+        double getTimeWaitingThisVisit() const { return timeWaiting - waitStartTime; }
         bool hadFault( double timeFlyingThisTick, double faultRoll );
         int getNumFaults() const { return static_cast<int>( std::ceil(numFaults) ); }
         double getPassengerMiles() const { return timeFlying * speed * passengerCapacity; }
@@ -75,6 +93,7 @@ class VTOL
         double timeCharging = 0;
         int numFaults = 0;
         double timeInStateThisTick = 0;     // time spent in the current state this tick of the simulation
+        double waitStartTime = 0;           // total time spent waiting when the VTOL last started waiting
 };
 
 /**
@@ -83,7 +102,7 @@ class VTOL
 class VTOLQueue
 {
     public:
-        VTOLQueue( VTOLStatus type, int randSeed, int capacity = UNLIMITED ) : generator( nullptr ), queueType(type), capacity(capacity)
+        VTOLQueue( VTOLStatus type, unsigned int randSeed, int capacity = UNLIMITED ) : generator( nullptr ), trace( nullptr ), queueType(type), capacity(capacity), randSeed(randSeed)
         {
             if( queueType == FLYING )
             {
@@ -106,13 +125,35 @@ class VTOLQueue
         bool empty();
         bool full();
         double getFaultRoll();
+        int getCapacity() const { return capacity; }
+
+        /**
+         * @brief change the number of VTOLs the queue accepts, VTOLs already in the queue beyond the new capacity are kept
+         * @param capacity the new capacity
+         */
+        void setCapacity( int capacity ) { this->capacity = capacity; }
+
+        /**
+         * @brief take the first VTOL of a make out of the queue
+         * @param make the make of VTOL to remove
+         * @return the removed VTOL, or nullptr if the queue has none of the make
+         */
+        VTOL * removeMake( VTOLMake make );
+
+        /**
+         * @brief pass every generated fault roll through a trace to record or replay them
+         * @param trace the trace to use, nullptr to generate rolls normally
+         */
+        void setTrace( RandomTrace * trace ) { this->trace = trace; }
     private:
         void initGenerator();
         std::default_random_engine * generator;
+        RandomTrace * trace;
         deque<VTOL *> q;
         VTOLStatus queueType;
         deque<VTOL *>::iterator it;
         int capacity;
+        unsigned int randSeed;
         vector<double> overchargeDurations;
 };
 
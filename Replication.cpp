@@ -0,0 +1,222 @@
+#include "Replication.h"
+
+#define NUM_T_VALUES 30
+
+// two sided 95% student t critical values for 1 through 30 degrees of freedom
+static const double T_CRITICAL_95[NUM_T_VALUES] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+#define Z_CRITICAL_95 1.960
+
+const char * getMetricName( SummaryMetric metric )
+{
+    switch( metric )
+    {
+        case AVG_FLIGHT_TIME:
+            return "Avg. Flight";
+        case AVG_WAIT_TIME:
+            return "Avg. Wait";
+        case AVG_CHARGE_TIME:
+            return "Avg. Charge";
+        case MAX_FAULTS:
+            return "Max Faults";
+        case PASSENGER_MILES:
+            return "Total Passenger Miles";
+    }
+    return "";
+}
+
+/**
+ * @brief extract the value of a metric from a make's summary
+ */
+static double getMetricValue( const MakeSummary & summary, SummaryMetric metric )
+{
+    switch( metric )
+    {
+        case AVG_FLIGHT_TIME:
+            return summary.avgFlightTime;
+        case AVG_WAIT_TIME:
+            return summary.avgWaitTime;
+        case AVG_CHARGE_TIME:
+            return summary.avgChargeTime;
+        case MAX_FAULTS:
+            return summary.maxFaults;
+        case PASSENGER_MILES:
+            return summary.totalPassengerMiles;
+    }
+    return 0.0;
+}
+
+ReplicationRunner::ReplicationRunner( unsigned int baseSeed, int batchSize, int maxReplications )
+    : baseSeed( baseSeed ), batchSize( std::max( batchSize, 1 ) ), maxReplications( maxReplications )
+{
+
+}
+
+void ReplicationRunner::addTarget( SummaryMetric metric, VTOLMake make, double relativeHalfWidth )
+{
+    targets.push_back( { metric, make, relativeHalfWidth } );
+    observations.push_back( vector<double>() );
+}
+
+int ReplicationRunner::run()
+{
+    while( numReplications < maxReplications && ( numReplications < MIN_REPLICATIONS || !targetsMet() ) )
+    {
+        runBatch( std::min( batchSize, maxReplications - numReplications ) );
+    }
+
+    return numReplications;
+}
+
+void ReplicationRunner::runBatch( int batchReplications )
+{
+    vector<SimulationEngine *> engines( batchReplications, nullptr );
+    vector<thread> threads;
+    for( int i = 0; i < batchReplications; ++i )
+    {
+        unsigned int seed = baseSeed + numReplications + i;
+        ThreadPlacement placement = getPlacement( cpusBySocket, i );
+        if( !cpusBySocket.empty() && placement.timerCpu == UNPINNED && !warnedUnplaced )
+        {
+            std::cerr << "warning: batch is larger than the free cpus of each socket, extra replications will not be pinned" << endl;
+            warnedUnplaced = true;
+        }
+        // create each engine on its own thread so its memory is first touched on the socket it runs on
+        threads.push_back( thread( [this, &engines, i, seed, placement]() {
+            if( !pinCurrentThread( placement.timerCpu ) )
+            {
+                std::cerr << "warning: could not pin replication to cpu " << placement.timerCpu << endl;
+            }
+            SimulationEngine * engine = new SimulationEngine( seed );
+            engine->setRealTime( false );
+            engine->setThreadPlacement( placement );
+            engine->setScenario( calendar );
+            engine->init();
+            engine->run( false );
+            engines[i] = engine;
+        } ) );
+    }
+
+    for( size_t i = 0; i < threads.size(); ++i )
+    {
+        threads[i].join();
+    }
+
+    // record observations in seed order so results do not depend on which replication finished first
+    for( SimulationEngine * engine : engines )
+    {
+        for( size_t i = 0; i < targets.size(); ++i )
+        {
+            MakeSummary summary = engine->getMakeSummary( targets[i].make );
+            // a replication whose fleet mix has none of the make says nothing about that make
+            if( summary.count > 0 )
+            {
+                addObservation( i, getMetricValue( summary, targets[i].metric ) );
+            }
+        }
+        delete engine;
+    }
+
+    numReplications += batchReplications;
+}
+
+void ReplicationRunner::setSocketPlacement( bool socketPlacement )
+{
+    cpusBySocket.clear();
+    if( socketPlacement )
+    {
+        cpusBySocket = getCpusBySocket();
+        if( cpusBySocket.empty() )
+        {
+            std::cerr << "warning: could not determine the cpus of each socket, replications will not be placed" << endl;
+        }
+    }
+}
+
+ThreadPlacement ReplicationRunner::getPlacement( const vector<vector<int>> & cpusBySocket, int batchIdx )
+{
+    ThreadPlacement placement;
+    if( cpusBySocket.empty() )
+        return placement;
+
+    // deal replications out to sockets in turn, then give each replication on a socket the next 4 cpus of that socket
+    const vector<int> & cpus = cpusBySocket[batchIdx % cpusBySocket.size()];
+    size_t firstCpu = ( batchIdx / cpusBySocket.size() ) * 4;
+    // sharing cpus between pinned replications is worse than letting the scheduler place them
+    if( firstCpu + 4 > cpus.size() )
+        return placement;
+
+    placement.timerCpu = cpus[firstCpu];
+    placement.flyingCpu = cpus[firstCpu + 1];
+    placement.chargingCpu = cpus[firstCpu + 2];
+    placement.waitingCpu = cpus[firstCpu + 3];
+    return placement;
+}
+
+bool ReplicationRunner::targetsMet() const
+{
+    for( size_t i = 0; i < targets.size(); ++i )
+    {
+        if( observations[i].size() < 2 )
+            return false;
+
+        double mean = getMean( observations[i] );
+        double halfWidth = getHalfWidth( observations[i] );
+        if( almostEqual( mean, 0 ) ? !almostEqual( halfWidth, 0 ) : halfWidth > targets[i].relativeHalfWidth * std::abs( mean ) )
+            return false;
+    }
+
+    return true;
+}
+
+double ReplicationRunner::getMean( const vector<double> & values )
+{
+    if( values.empty() )
+        return 0.0;
+
+    double sum = 0.0;
+    for( double value : values )
+    {
+        sum += value;
+    }
+    return sum / values.size();
+}
+
+double ReplicationRunner::getHalfWidth( const vector<double> & values )
+{
+    size_t n = values.size();
+    if( n < 2 )
+        return 0.0;
+
+    double mean = getMean( values );
+    double sumSquares = 0.0;
+    for( double value : values )
+    {
+        sumSquares += ( value - mean ) * ( value - mean );
+    }
+
+    // n - 1 degrees of freedom, the table starts at 1 degree of freedom
+    double critical = ( n - 1 <= NUM_T_VALUES ? T_CRITICAL_95[n - 2] : Z_CRITICAL_95 );
+    return critical * std::sqrt( sumSquares / ( n - 1 ) / n );
+}
+
+void ReplicationRunner::displayResults()
+{
+    cout << "Replications run: " << numReplications << ( targetsMet() ? "" : " (limit reached before targets were met)" ) << endl;
+    cout << "Make       | Metric                | Samples |        Mean |  95% CI +/- | Rel. Width |  Target |" << endl;
+    cout << "------------------------------------------------------------------------------------------------" << endl;
+    for( size_t i = 0; i < targets.size(); ++i )
+    {
+        double mean = getMean( observations[i] );
+        double halfWidth = getHalfWidth( observations[i] );
+        cout << std::left << std::setw(11) << getMakeName( targets[i].make ) << "| " 
+             << std::setw(22) << getMetricName( targets[i].metric ) << std::right << "|"
+             << std::setw(8) << observations[i].size() << " |"
+             << std::fixed << std::setw(12) << std::setprecision(2) << mean << " |"
+             << std::setw(12) << std::setprecision(2) << halfWidth << " |"
+             << std::setw(11) << std::setprecision(4) << ( almostEqual( mean, 0 ) ? 0.0 : halfWidth / std::abs( mean ) ) << " |"
+             << std::setw(8) << std::setprecision(4) << targets[i].relativeHalfWidth << " |" << endl;
+    }
+}
@@ -0,0 +1,132 @@
+#ifndef REPLICATION_H
+#define REPLICATION_H
+
+#include "Simulation.h"
+
+#ifndef MIN_REPLICATIONS
+#define MIN_REPLICATIONS 5
+#endif
+
+#ifndef MAX_REPLICATIONS
+#define MAX_REPLICATIONS 1000
+#endif
+
+enum SummaryMetric
+{
+    AVG_FLIGHT_TIME = 0,
+    AVG_WAIT_TIME = 1,
+    AVG_CHARGE_TIME = 2,
+    MAX_FAULTS = 3,
+    PASSENGER_MILES = 4
+};
+
+/**
+ * @brief get the display name of a summary metric
+ * @param metric the metric to retrieve the name of
+ */
+const char * getMetricName( SummaryMetric metric );
+
+/**
+ * a summary metric of a make whose 95% confidence interval must be narrowed to a given width
+ */
+struct ReplicationTarget
+{
+    SummaryMetric metric;
+    VTOLMake make;
+    double relativeHalfWidth;   // target confidence interval half-width as a fraction of the mean
+};
+
+/**
+ * runs independent replications of the simulation in parallel batches until the confidence interval
+ * of every target metric is narrow enough
+ */
+class ReplicationRunner
+{
+    public:
+        /**
+         * @param baseSeed seed of the first replication, each later replication uses the next seed
+         * @param batchSize number of replications to run in parallel per batch
+         * @param maxReplications number of replications after which to stop even if targets are not met
+         */
+        ReplicationRunner( unsigned int baseSeed, int batchSize, int maxReplications = MAX_REPLICATIONS );
+
+        /**
+         * @brief add a metric whose confidence interval must be met before replication stops
+         * @param metric which summary metric to track
+         * @param make which make's summary the metric is taken from
+         * @param relativeHalfWidth target confidence interval half-width as a fraction of the mean
+         */
+        void addTarget( SummaryMetric metric, VTOLMake make, double relativeHalfWidth );
+
+        /**
+         * @brief spread the replications of each batch across sockets, pinning each replication's threads and memory to one socket
+         * @param socketPlacement true to place each replication on a single socket
+         */
+        void setSocketPlacement( bool socketPlacement );
+
+        /**
+         * @brief run every replication with the same scheduled scenario events
+         * @param calendar the scenario events to apply in each replication
+         */
+        void setScenario( const EventCalendar & calendar ) { this->calendar = calendar; }
+
+        /**
+         * @brief run batches of replications until every target is met or the replication limit is reached
+         * @return the number of replications run
+         */
+        int run();
+
+        /**
+         * @brief display the estimate and confidence interval of each target
+         */
+        void displayResults();
+
+        /**
+         * @brief determine if the confidence interval of every target is within its target width
+         */
+        bool targetsMet() const;
+
+        /**
+         * @brief record a replication's observation of a target
+         * @param targetIdx index of the target in the order targets were added
+         * @param value the value of the target's metric in the replication
+         */
+        void addObservation( int targetIdx, double value ) { observations[targetIdx].push_back( value ); }
+
+        /**
+         * @brief mean of a sample of observations
+         */
+        static double getMean( const vector<double> & values );
+
+        /**
+         * @brief half-width of the 95% confidence interval of the mean of a sample of observations
+         */
+        static double getHalfWidth( const vector<double> & values );
+
+        /**
+         * @brief choose cpus on a single socket for every thread of a replication
+         * replications are dealt out to sockets in turn and each takes the next 4 cpus of its socket, any replication
+         * that would share cpus with another is left unpinned
+         * @param cpusBySocket cpus of each socket to place replications on, empty to leave every replication unpinned
+         * @param batchIdx index of the replication within its batch
+         */
+        static ThreadPlacement getPlacement( const vector<vector<int>> & cpusBySocket, int batchIdx );
+    private:
+        /**
+         * @brief run a batch of replications in parallel and record their observations
+         * @param batchReplications number of replications in the batch
+         */
+        void runBatch( int batchReplications );
+
+        vector<ReplicationTarget> targets;
+        vector<vector<double>> observations;    // observations of each target from each replication
+        vector<vector<int>> cpusBySocket;       // cpus to place replications on, empty if replications are not placed
+        EventCalendar calendar;
+        bool warnedUnplaced = false;
+        unsigned int baseSeed;
+        int batchSize;
+        int maxReplications;
+        int numReplications = 0;
+};
+
+#endif
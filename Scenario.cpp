@@ -0,0 +1,115 @@
+#include "Scenario.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+
+/**
+ * @brief order events by time only so events at the same time keep the order they were scheduled in
+ */
+static bool earlierEvent( const ScenarioEvent & a, const ScenarioEvent & b )
+{
+    return a.time < b.time;
+}
+
+void EventCalendar::schedule( const ScenarioEvent & event )
+{
+    vector<ScenarioEvent>::iterator pos = std::upper_bound( events.begin() + nextEvent, events.end(), event, earlierEvent );
+    events.insert( pos, event );
+}
+
+bool EventCalendar::load( const string & path )
+{
+    std::ifstream in( path );
+    if( !in )
+    {
+        loadError = "could not open file";
+        return false;
+    }
+
+    // append events as they are read and sort once at the end, inserting each in order would be quadratic
+    vector<ScenarioEvent> loaded;
+    string line;
+    int lineNum = 0;
+    while( std::getline( in, line ) )
+    {
+        ++lineNum;
+        loadError = "line " + std::to_string( lineNum ) + ": ";
+        std::istringstream fields( line );
+        string first;
+        if( !( fields >> first ) || first[0] == '#' )
+            continue;
+
+        if( first == "fleet" )
+        {
+            if( !( fields >> initialFleet ) || initialFleet < 0 )
+            {
+                loadError += "expected a fleet size of 0 or more";
+                return false;
+            }
+            string extra;
+            if( fields >> extra )
+            {
+                loadError += "unexpected text after fleet size";
+                return false;
+            }
+            continue;
+        }
+
+        ScenarioEvent event = { 0.0, AIRCRAFT_ARRIVAL, ALPHA, 0 };
+        string type;
+        std::istringstream time( first );
+        if( !( time >> event.time ) || !time.eof() )
+        {
+            loadError += "expected a time in hours or fleet, found '" + first + "'";
+            return false;
+        }
+        if( !( fields >> type ) )
+        {
+            loadError += "expected an event after the time";
+            return false;
+        }
+
+        if( type == "arrive" || type == "depart" )
+        {
+            string make;
+            if( !( fields >> make ) || !parseMake( make.c_str(), event.make ) )
+            {
+                loadError += "unknown make '" + make + "'";
+                return false;
+            }
+            event.type = ( type == "arrive" ? AIRCRAFT_ARRIVAL : AIRCRAFT_DEPARTURE );
+        }
+        else if( type == "charger_offline" || type == "charger_online" )
+        {
+            event.type = ( type == "charger_offline" ? CHARGER_OFFLINE : CHARGER_ONLINE );
+        }
+        else
+        {
+            loadError += "unknown event '" + type + "'";
+            return false;
+        }
+
+        if( !( fields >> event.count ) || event.count < 0 )
+        {
+            loadError += "expected a count of 0 or more";
+            return false;
+        }
+        string extra;
+        if( fields >> extra )
+        {
+            loadError += "unexpected text after count";
+            return false;
+        }
+        loaded.push_back( event );
+    }
+
+    std::stable_sort( loaded.begin(), loaded.end(), earlierEvent );
+    // merge with any events already scheduled, keeping those first when times are equal
+    vector<ScenarioEvent> merged;
+    std::merge( events.begin() + nextEvent, events.end(), loaded.begin(), loaded.end(), std::back_inserter( merged ), earlierEvent );
+    events = merged;
+    nextEvent = 0;
+    loadError.clear();
+    return true;
+}
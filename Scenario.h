@@ -0,0 +1,84 @@
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include <string>
+#include <vector>
+#include "Models.h"
+
+using std::string;
+using std::vector;
+
+#define DEFAULT_FLEET -1
+
+enum ScenarioEventType
+{
+    AIRCRAFT_ARRIVAL = 0,
+    AIRCRAFT_DEPARTURE = 1,
+    CHARGER_OFFLINE = 2,
+    CHARGER_ONLINE = 3
+};
+
+/**
+ * a change to the fleet or chargers scheduled at a point in simulated time
+ */
+struct ScenarioEvent
+{
+    double time;                // simulated hours from the start of the run
+    ScenarioEventType type;
+    VTOLMake make;              // make of aircraft arriving or departing, unused for charger events
+    int count;                  // number of aircraft or chargers affected
+};
+
+/**
+ * calendar of scenario events kept sorted by time and consumed in order as the simulation advances
+ */
+class EventCalendar
+{
+    public:
+        /**
+         * @brief add an event to the calendar, after any events already scheduled for the same time
+         * @param event the event to schedule
+         */
+        void schedule( const ScenarioEvent & event );
+
+        /**
+         * @brief determine if the next unconsumed event is due
+         * @param time simulated hours that have elapsed
+         */
+        bool hasDueEvent( double time ) const { return nextEvent < events.size() && events[nextEvent].time <= time; }
+
+        /**
+         * @brief consume the next event in time order
+         */
+        const ScenarioEvent & popEvent() { return events[nextEvent++]; }
+
+        /**
+         * @brief number of randomly selected aircraft to start the run with, DEFAULT_FLEET to use NUM_AIRCRAFT
+         */
+        int getInitialFleet() const { return initialFleet; }
+        void setInitialFleet( int initialFleet ) { this->initialFleet = initialFleet; }
+
+        /**
+         * @brief read a scenario from a text file with one entry per line, blank lines and lines starting with # are ignored
+         *   fleet <count>                          number of randomly selected aircraft at the start of the run
+         *   <hours> arrive <make> <count>          aircraft of a make enter service flying with a full charge
+         *   <hours> depart <make> <count>          aircraft of a make leave service, preferring those flying
+         *   <hours> charger_offline <count>        chargers stop accepting aircraft, aircraft already charging finish
+         *   <hours> charger_online <count>         chargers return to service
+         * @param path the file to read
+         * @return true if every line was read successfully, otherwise getLoadError describes the failure
+         */
+        bool load( const string & path );
+
+        /**
+         * @brief description of why the last load failed, including the line number if a line could not be read
+         */
+        const string & getLoadError() const { return loadError; }
+    private:
+        vector<ScenarioEvent> events;
+        size_t nextEvent = 0;
+        int initialFleet = DEFAULT_FLEET;
+        string loadError;
+};
+
+#endif
@@ -1,21 +1,108 @@
 #include "Simulation.h"
+#include <algorithm>
 
-// set up barriers for thread syncronization
-barrier g_syncPoint(4);  // one for each queue thread and one for watcher thread
-barrier g_tickTiming(2); // one for watcher and one for timer threads
-SimulationEngine::SimulationEngine()
-    : flyingQueue( FLYING, rand() ), waitingQueue( WAITING, rand() ), chargingQueue( CHARGING, rand(), NUM_CHARGERS ), tickLength( 1.0 / TICK_PER_SEC ), hoursPerTick( tickLength / 60 )
+SimulationEngine::SimulationEngine() : SimulationEngine( clock() )
+{
+
+}
+
+SimulationEngine::SimulationEngine( unsigned int seed )
+    : flyingQueue( FLYING, seed ), waitingQueue( WAITING, seed ), chargingQueue( CHARGING, seed, NUM_CHARGERS ), syncPoint( 4 ), tickTiming( 2 ), seed( seed ), tickLength( 1.0 / TICK_PER_SEC ), hoursPerTick( tickLength / 60 ),
+      metrics( NUM_METRIC_BUCKETS, ( TICK_PER_SEC * SIM_DUR_SEC + NUM_METRIC_BUCKETS - 1 ) / NUM_METRIC_BUCKETS, hoursPerTick, NUM_AIRCRAFT, NUM_WAIT_HIST_BINS, WAIT_HIST_BIN_HOURS )
 {
 
 }
 
 void SimulationEngine::init()
 {
-    std::uniform_int_distribution distribution( 0, 4 );
-    std::default_random_engine generator( clock() );
-    for( int i = 0; i < NUM_AIRCRAFT; ++i )
+    if( placement.flyingCpu == UNPINNED )
     {
-        addNewVTOL( static_cast<VTOLMake>( distribution( generator ) ) );
+        createFleet();
+        return;
+    }
+
+    // the first thread to touch memory places it on its socket, so allocate the fleet from the flying thread's cpu
+    thread allocator( [this]() {
+        pinToCpu( placement.flyingCpu );
+        createFleet();
+    } );
+    allocator.join();
+}
+
+void SimulationEngine::createFleet()
+{
+    std::uniform_int_distribution distribution( 0, NUM_MAKES - 1 );
+    // seed differently from the flying queue so the fleet mix and fault rolls are not correlated
+    std::seed_seq seq{ seed, static_cast<unsigned int>( NUM_MAKES ) };
+    std::default_random_engine generator( seq );
+    int fleetSize = ( calendar.getInitialFleet() == DEFAULT_FLEET ? NUM_AIRCRAFT : calendar.getInitialFleet() );
+    for( int i = 0; i < fleetSize; ++i )
+    {
+        int make = distribution( generator );
+        if( trace )
+        {
+            make = trace->traceMake( make );
+        }
+        addNewVTOL( static_cast<VTOLMake>( make ) );
+    }
+    applyScenarioEvents( 0.0 );
+    addPendingArrivals();
+}
+
+void SimulationEngine::addPendingArrivals()
+{
+    for( VTOLMake make : pendingArrivals )
+    {
+        addNewVTOL( make );
+    }
+    pendingArrivals.clear();
+}
+
+void SimulationEngine::applyScenarioEvents( double time )
+{
+    while( calendar.hasDueEvent( time ) )
+    {
+        const ScenarioEvent & event = calendar.popEvent();
+        switch( event.type )
+        {
+            case AIRCRAFT_ARRIVAL:
+                // created later by the flying thread so their memory is first touched on its cpu
+                pendingArrivals.insert( pendingArrivals.end(), event.count, event.make );
+                break;
+            case AIRCRAFT_DEPARTURE:
+                for( int i = 0; i < event.count; ++i )
+                {
+                    // an aircraft due to arrive this tick has not been created yet, so cancel its arrival instead
+                    vector<VTOLMake>::iterator pending = std::find( pendingArrivals.begin(), pendingArrivals.end(), event.make );
+                    if( pending != pendingArrivals.end() )
+                    {
+                        pendingArrivals.erase( pending );
+                        continue;
+                    }
+
+                    // prefer taking aircraft out of service that are not holding up a charger
+                    VTOL * departed = flyingQueue.removeMake( event.make );
+                    if( !departed )
+                    {
+                        departed = waitingQueue.removeMake( event.make );
+                        if( departed )
+                            metrics.recordUnfinishedWait( departed->getTimeWaitingThisVisit() );
+                    }
+                    if( !departed )
+                        departed = chargingQueue.removeMake( event.make );
+                    if( !departed )
+                        break;
+                }
+                break;
+            case CHARGER_OFFLINE:
+                chargersInService = std::max( chargersInService - event.count, 0 );
+                chargingQueue.setCapacity( chargersInService );
+                break;
+            case CHARGER_ONLINE:
+                chargersInService = std::min( chargersInService + event.count, NUM_CHARGERS );
+                chargingQueue.setCapacity( chargersInService );
+                break;
+        }
     }
 }
 
@@ -25,7 +112,7 @@ void SimulationEngine::addNewVTOL( VTOLMake make )
     flyingQueue.push( VTOLs[VTOLs.size() - 1] );
 }
 
-void SimulationEngine::run()
+void SimulationEngine::run( bool displaySummary )
 {
     // spawn threads
     vector<thread> threads;
@@ -33,34 +120,68 @@ void SimulationEngine::run()
     threads.push_back( thread( &SimulationEngine::processQueue, this, FLYING ) );
     threads.push_back( thread( &SimulationEngine::processQueue, this, CHARGING ) );
     threads.push_back( thread( &SimulationEngine::processQueue, this, WAITING ) );
-    
+
     // loop through ticks of the simulation
     for( int i = 0; i < TICK_PER_SEC * SIM_DUR_SEC; ++ i )
     {
         // process queues
-        g_syncPoint.arrive_and_wait();
+        syncPoint.arrive_and_wait();
         // move charging and flying vtols
-        g_syncPoint.arrive_and_wait();
+        syncPoint.arrive_and_wait();
         // move waiting vtols
-        g_syncPoint.arrive_and_wait();
-        g_tickTiming.arrive_and_wait();
+        syncPoint.arrive_and_wait();
+        tickTiming.arrive_and_wait();
     }    
 
     for( int i = 0; i < threads.size(); ++i )
     {
         threads[i].join();
     }
-    prepareSummary();
+
+    if( trace )
+    {
+        trace->finish( getFinalState(), getSummaryValues() );
+    }
+
+    if( displaySummary )
+    {
+        prepareSummary();
+    }
+}
+
+void SimulationEngine::setTrace( RandomTrace * trace )
+{
+    this->trace = trace;
+    flyingQueue.setTrace( trace );
 }
 
 int SimulationEngine::processQueue( VTOLStatus queueType )
 {
-    
+    // pin before doing any work so everything this thread allocates is first touched on its cpu
+    switch( queueType )
+    {
+        case FLYING:
+            pinToCpu( placement.flyingCpu );
+            break;
+        case CHARGING:
+            pinToCpu( placement.chargingCpu );
+            break;
+        case WAITING:
+            pinToCpu( placement.waitingCpu );
+            break;
+    }
+
     double timeElapsed = 0.0;
     for( int tickNum = 0; tickNum < TICK_PER_SEC * SIM_DUR_SEC; ++tickNum )
     {
         timeElapsed += tickLength;
         vector<VTOL *> * stateChangedVTOLs = nullptr;
+        // aircraft scheduled to arrive last tick join the flying queue before it is processed
+        if( queueType == FLYING )
+        {
+            addPendingArrivals();
+        }
+
         // advance time for all VTOLs in the relevant queue
         if( queueType != WAITING )
         {
@@ -68,23 +189,41 @@ int SimulationEngine::processQueue( VTOLStatus queueType )
         }
         updateVTOLs( queueType, stateChangedVTOLs );
         
-        g_syncPoint.arrive_and_wait();
+        syncPoint.arrive_and_wait();
         // move vtols that are no longer flying or charging to appropriate queue
         if( queueType != WAITING )
         {
             moveVTOLs( queueType, stateChangedVTOLs );
         }
-        g_syncPoint.arrive_and_wait();
+        syncPoint.arrive_and_wait();
 
-        // move waiting vtols to charger if any are available
+        // apply scenario events due this tick and move waiting vtols to charger if any are available
         if( queueType == WAITING )
         {
+            applyScenarioEvents( ( tickNum + 1 ) * hoursPerTick );
             moveVTOLs( queueType, stateChangedVTOLs );
         }
-        g_syncPoint.arrive_and_wait();
+        syncPoint.arrive_and_wait();
         delete stateChangedVTOLs;
     }
 
+    // aircraft scheduled during the final tick still join the fleet so they appear in the summary
+    if( queueType == FLYING )
+    {
+        addPendingArrivals();
+    }
+
+    // record the waits of aircraft that never reached a charger so the longest waits are not left out
+    if( queueType == WAITING )
+    {
+        for( int i = 0; i < waitingQueue.size(); ++i )
+        {
+            VTOL * curVTOL = waitingQueue.pop();
+            metrics.recordUnfinishedWait( curVTOL->getTimeWaitingThisVisit() );
+            waitingQueue.push( curVTOL );
+        }
+    }
+
     return 0;
 }
 
@@ -92,12 +231,21 @@ void SimulationEngine::updateVTOLs( VTOLStatus queueType, vector<VTOL *> * state
 {
     VTOLQueue * threadQueue = getQueuePointerFromType( queueType );
     int VTOLsInQueue = threadQueue->size();
+    if( queueType == CHARGING )
+    {
+        chargersInUse = VTOLsInQueue;
+    }
     for( int i = 0; i < VTOLsInQueue; ++i )
     {
         // get next vtol to process, using the order preserving getNextVTOL if queue is waiting queue
         VTOL * curVTOL = threadQueue->pop();
 
+        double timeChargedBefore = curVTOL->getTimeCharging();
         double timeInEndState = curVTOL->updateVTOL( hoursPerTick, threadQueue->getFaultRoll() );
+        if( queueType == CHARGING )
+        {
+            chargerBusyHours += curVTOL->getTimeCharging() - timeChargedBefore;
+        }
         if( stateChangedVTOLs && queueType != curVTOL->getStatus() )
         {
             stateChangedVTOLs->push_back( curVTOL );
@@ -141,6 +289,7 @@ void SimulationEngine::moveVTOLs( VTOLStatus queueType, vector<VTOL *> * stateCh
         while( !chargingQueue.full() && !waitingQueue.empty() )
         {
             VTOL * curVTOL = waitingQueue.pop();
+            double timeChargedBefore = curVTOL->getTimeCharging();
             if( chargerAvailIdx >= chargerAvailabilityTimes.size() )
             {
                 curVTOL->moveToCharger( hoursPerTick );
@@ -149,10 +298,17 @@ void SimulationEngine::moveVTOLs( VTOLStatus queueType, vector<VTOL *> * stateCh
             {
                 curVTOL->moveToCharger( chargerAvailabilityTimes.at( chargerAvailIdx ) );
             }
+            chargerBusyHours += curVTOL->getTimeCharging() - timeChargedBefore;
+            metrics.recordTimeToCharger( curVTOL->getTimeWaitingThisVisit() );
             chargingQueue.push( curVTOL );
         }
 
         chargerAvailabilityTimes.clear();
+
+        // all queues have settled for this tick so record the tick's charger and waiting queue counters
+        // aircraft still finishing on a charger taken out of service keep that charger in use
+        metrics.recordTick( chargerBusyHours, std::max( chargersInService, chargersInUse ), waitingQueue.size() );
+        chargerBusyHours = 0.0;
     }
 }
 
@@ -175,81 +331,101 @@ VTOLQueue * SimulationEngine::getQueuePointerFromType( VTOLStatus queueType )
     return retQueue;
 }
 
+void SimulationEngine::pinToCpu( int cpu )
+{
+    if( !pinCurrentThread( cpu ) )
+    {
+        std::cerr << "warning: could not pin simulation thread to cpu " << cpu << endl;
+    }
+}
+
 int SimulationEngine::syncThreads()
 {
+    pinToCpu( placement.timerCpu );
     std::chrono::system_clock::time_point start = std::chrono::system_clock::now();
     
     double msPerTick = tickLength * 1000;
     for( int i = 0; i < TICK_PER_SEC * SIM_DUR_SEC; ++ i )
     {
-        std::this_thread::sleep_until( start + std::chrono::milliseconds( (int) msPerTick * ( i+1 ) ) );
-        g_tickTiming.arrive_and_wait();
+        if( realTime )
+        {
+            std::this_thread::sleep_until( start + std::chrono::milliseconds( (int) msPerTick * ( i+1 ) ) );
+        }
+        tickTiming.arrive_and_wait();
     }
     return 0;
 }
 
+vector<AircraftState> SimulationEngine::getFinalState() const
+{
+    vector<AircraftState> states;
+    for( const VTOL * curVTOL : VTOLs )
+    {
+        states.push_back( { curVTOL->getMake(), curVTOL->getStatus(), curVTOL->getTimeInFlight(), curVTOL->getTimeWaiting(), 
+                            curVTOL->getTimeCharging(), curVTOL->getNumFaults() } );
+    }
+    return states;
+}
+
+vector<double> SimulationEngine::getSummaryValues() const
+{
+    vector<double> values;
+    for( int i = 0; i < NUM_MAKES; ++i )
+    {
+        MakeSummary summary = getMakeSummary( static_cast<VTOLMake>( i ) );
+        values.insert( values.end(), { static_cast<double>( summary.count ), summary.avgFlightTime, summary.avgWaitTime, summary.avgChargeTime, 
+                                       static_cast<double>( summary.maxFaults ), summary.totalPassengerMiles } );
+    }
+    return values;
+}
+
 void SimulationEngine::prepareSummary()
 {
     cout << "Make       | Avg. Flight |  Avg. Wait  | Avg. Charge |  Max Faults | Total Passenger Miles |" << endl;
     cout << "--------------------------------------------------------------------------------------------" << endl;
-    for( int i = 0; i < 5; ++i )
+    for( int i = 0; i < NUM_MAKES; ++i )
     {
         displayMakeSummary( static_cast<VTOLMake>( i ) );
     }
+    metrics.display();
 }
 
-void SimulationEngine::displayMakeSummary( VTOLMake make )
+MakeSummary SimulationEngine::getMakeSummary( VTOLMake make ) const
 {
-    int count = 0;
-    double flightTime = 0.0;
-    double chargeTime = 0.0;
-    double waitTime = 0.0;
-    int maxFaults = 0;
-    double totalPassengerMiles = 0.0;
-    
+    MakeSummary summary;
     for( const VTOL * curVTOL : VTOLs )
     {
         if( curVTOL->getMake() == make )
         {
-            ++count;
-            flightTime += curVTOL->getTimeInFlight();
-            chargeTime += curVTOL->getTimeCharging();
-            waitTime += curVTOL->getTimeWaiting();
+            ++summary.count;
+            summary.avgFlightTime += curVTOL->getTimeInFlight();
+            summary.avgChargeTime += curVTOL->getTimeCharging();
+            summary.avgWaitTime += curVTOL->getTimeWaiting();
             int curFaults = curVTOL->getNumFaults();
-            if( curFaults > maxFaults )
-                maxFaults = curFaults;
-            totalPassengerMiles += curVTOL->getPassengerMiles();
+            if( curFaults > summary.maxFaults )
+                summary.maxFaults = curFaults;
+            summary.totalPassengerMiles += curVTOL->getPassengerMiles();
         }
     }
 
-    if( count > 1 )
+    if( summary.count > 1 )
     {
-        flightTime /= count;
-        chargeTime /= count;
-        waitTime /= count;
+        summary.avgFlightTime /= summary.count;
+        summary.avgChargeTime /= summary.count;
+        summary.avgWaitTime /= summary.count;
     }
 
-    switch( make )
-    {
-        case ALPHA:
-            cout << "Alpha      ";
-            break;
-        case BETA:
-            cout << "Beta       ";
-            break;
-        case CHARLIE:
-            cout << "Charlie    ";
-            break;
-        case DELTA:
-            cout << "Delta      ";
-            break;
-        case ECHO:
-            cout << "Echo       ";
-            break;
-    }
-    cout << "|" << std::fixed << std::setw(12) << std::setprecision(2) << flightTime << " |" 
-                << std::setw(12) << std::setprecision(2) << waitTime << " |" 
-                << std::setw(12) << std::setprecision(2) << chargeTime << " |" 
-                << std::setw(12) << maxFaults << " |" 
-                << std::setw(22) << std::setprecision(2) << totalPassengerMiles << " |" << endl;
+    return summary;
+}
+
+void SimulationEngine::displayMakeSummary( VTOLMake make )
+{
+    MakeSummary summary = getMakeSummary( make );
+
+    cout << std::left << std::setw(11) << getMakeName( make ) << std::right;
+    cout << "|" << std::fixed << std::setw(12) << std::setprecision(2) << summary.avgFlightTime << " |" 
+                << std::setw(12) << std::setprecision(2) << summary.avgWaitTime << " |" 
+                << std::setw(12) << std::setprecision(2) << summary.avgChargeTime << " |" 
+                << std::setw(12) << summary.maxFaults << " |" 
+                << std::setw(22) << std::setprecision(2) << summary.totalPassengerMiles << " |" << endl;
 }
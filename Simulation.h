@@ -7,6 +7,8 @@
 #include <barrier>
 #include "Models.h"
 #include "Utils.h"
+#include "Metrics.h"
+#include "Scenario.h"
 #include <chrono>
 #include <iomanip>
 
@@ -26,16 +28,57 @@
 #define TICK_PER_SEC 30
 #endif
 
+#ifndef NUM_METRIC_BUCKETS
+#define NUM_METRIC_BUCKETS 12
+#endif
+
+#ifndef NUM_WAIT_HIST_BINS
+#define NUM_WAIT_HIST_BINS 12
+#endif
+
+#ifndef WAIT_HIST_BIN_HOURS
+#define WAIT_HIST_BIN_HOURS 0.1
+#endif
+
 using std::thread;
 using std::barrier;
 using std::string;
 using std::cout;
 using std::endl;
 
+/**
+ * summary statistics of all VTOLs of a single make at the end of a simulation
+ */
+struct MakeSummary
+{
+    int count = 0;
+    double avgFlightTime = 0.0;
+    double avgWaitTime = 0.0;
+    double avgChargeTime = 0.0;
+    int maxFaults = 0;
+    double totalPassengerMiles = 0.0;
+};
+
+/**
+ * cpus to pin each of the simulation's threads to, UNPINNED leaves the thread free to run on any cpu
+ */
+struct ThreadPlacement
+{
+    int timerCpu = UNPINNED;
+    int flyingCpu = UNPINNED;
+    int chargingCpu = UNPINNED;
+    int waitingCpu = UNPINNED;
+};
+
 class SimulationEngine
 {
     public:
         SimulationEngine();
+
+        /**
+         * @param seed seed for the fleet mix and fault roll random number generation
+         */
+        SimulationEngine( unsigned int seed );
         ~SimulationEngine() 
         {
             for( VTOL * curVTOL : VTOLs )
@@ -45,13 +88,53 @@ class SimulationEngine
         }
         /**
          * @brief initialize simulation to default configuration
+         * if the flying thread is pinned the fleet is allocated from its cpu so the memory it processes is local to its socket
          */
         void init();
 
         /**
          * @brief run the simulation
+         * @param displaySummary whether to print the summary table once the simulation is complete
          */
-        void run();
+        void run( bool displaySummary = true );
+
+        /**
+         * @brief set whether ticks are paced to wall clock time or processed as fast as possible
+         * @param realTime true to sleep until each tick's wall clock time before advancing
+         */
+        void setRealTime( bool realTime ) { this->realTime = realTime; }
+
+        /**
+         * @brief set the cpus the simulation's threads are pinned to, must be called before init to place the fleet's memory
+         * @param placement cpu to pin each thread to
+         */
+        void setThreadPlacement( const ThreadPlacement & placement ) { this->placement = placement; }
+
+        /**
+         * @brief record or replay every random draw of the run, must be called before init
+         * the trace is given the final state and summary once the run completes
+         * @param trace the trace to use, nullptr to draw normally
+         */
+        void setTrace( RandomTrace * trace );
+
+        /**
+         * @brief schedule aircraft arrivals and departures and charger outages during the run, must be called before init
+         * arrivals join the flying queue at the start of the tick after they are due and are allocated by the flying thread
+         * departed aircraft stop being simulated but their totals up to departure remain in the summary
+         * @param calendar the scenario events to apply as their times are reached
+         */
+        void setScenario( const EventCalendar & calendar ) { this->calendar = calendar; }
+
+        /**
+         * @brief compute the summary statistics for a specific make of VTOL
+         * @param make which make's VTOLs to summarize
+         */
+        MakeSummary getMakeSummary( VTOLMake make ) const;
+
+        /**
+         * @brief get the charger utilization, waiting queue and time to charger counters collected during the run
+         */
+        const SimulationMetrics & getMetrics() const { return metrics; }
 
         /**
          * @brief syncronize each tick of the simulation to a given amount of time
@@ -59,17 +142,49 @@ class SimulationEngine
         int syncThreads();
 
         /**
-         * @brief add a VTOL to the simulation
+         * @brief add a VTOL to the simulation, its memory is allocated by the calling thread
          * @param make make of the VTOL to create and add to the simulation
          */
         void addNewVTOL( VTOLMake make );
     private:
+        /**
+         * @brief pin the calling thread to a cpu, warning if it could not be pinned
+         * @param cpu index of the cpu to pin to, UNPINNED leaves the thread unchanged
+         */
+        void pinToCpu( int cpu );
+
+        /**
+         * @brief create the randomly selected starting fleet along with any aircraft scheduled to arrive at the start
+         */
+        void createFleet();
+
+        /**
+         * @brief apply every scheduled scenario event due by a given time, must only be called while no queue is being processed
+         * @param time simulated hours that have elapsed
+         */
+        void applyScenarioEvents( double time );
+
+        /**
+         * @brief create the aircraft scheduled to arrive since the last call, must only be called from the flying thread or before the run
+         */
+        void addPendingArrivals();
+
         /**
          * @brief function to process all the VTOLs in a queue of a given type 
          * @param queueType which queue this function should process
          */
         int processQueue( VTOLStatus queueType );
         
+        /**
+         * @brief collect the final state of each VTOL in the order they were added
+         */
+        vector<AircraftState> getFinalState() const;
+
+        /**
+         * @brief collect the values of every make's summary in the order they are displayed
+         */
+        vector<double> getSummaryValues() const;
+
         /**
          * @brief prepare and display the summary of the simulation
          */
@@ -106,8 +221,20 @@ class SimulationEngine
         VTOLQueue chargingQueue;                    // queue of charging VTOLs to be processed
         vector<VTOL *> VTOLs;
         vector<double> chargerAvailabilityTimes;    // vector to track how much time within the current tick chargers were available
+        barrier<> syncPoint;                        // one for each queue thread and one for watcher thread
+        barrier<> tickTiming;                       // one for watcher and one for timer threads
+        unsigned int seed;
+        bool realTime = true;
+        ThreadPlacement placement;
+        RandomTrace * trace = nullptr;
+        EventCalendar calendar;
+        vector<VTOLMake> pendingArrivals;           // makes of scheduled arrivals waiting to be created by the flying thread
+        int chargersInService = NUM_CHARGERS;
+        int chargersInUse = 0;                      // number of VTOLs charging at the start of the current tick
+        double chargerBusyHours = 0.0;              // total time chargers spent charging VTOLs within the current tick
         double tickLength;
         const double hoursPerTick;
+        SimulationMetrics metrics;
 };
 
 #endif
\ No newline at end of file
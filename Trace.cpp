@@ -0,0 +1,202 @@
+#include "Trace.h"
+#include <fstream>
+#include <iostream>
+#include <cstdint>
+#include <cstring>
+
+using std::cout;
+using std::endl;
+
+#define TRACE_MAGIC "VTRC"
+#define TRACE_VERSION 1
+
+int RandomTrace::traceMake( int drawn )
+{
+    if( mode == RECORD )
+    {
+        makeDraws.push_back( static_cast<unsigned char>( drawn ) );
+        return drawn;
+    }
+
+    // a run drawing more than was recorded keeps its own draws and is reported as a mismatch when it finishes
+    if( makeIdx >= makeDraws.size() )
+    {
+        ++makeIdx;
+        return drawn;
+    }
+    return makeDraws[makeIdx++];
+}
+
+double RandomTrace::traceFaultRoll( double rolled )
+{
+    if( mode == RECORD )
+    {
+        faultRolls.push_back( rolled );
+        return rolled;
+    }
+
+    if( rollIdx >= faultRolls.size() )
+    {
+        ++rollIdx;
+        return rolled;
+    }
+    return faultRolls[rollIdx++];
+}
+
+void RandomTrace::finish( const vector<AircraftState> & states, const vector<double> & summary )
+{
+    if( mode == RECORD )
+    {
+        finalStates = states;
+        finalSummary = summary;
+        return;
+    }
+
+    mismatches = 0;
+    if( makeIdx != makeDraws.size() )
+    {
+        cout << "Replay used " << makeIdx << " fleet mix draws, recorded " << makeDraws.size() << endl;
+        ++mismatches;
+    }
+    if( rollIdx != faultRolls.size() )
+    {
+        cout << "Replay used " << rollIdx << " fault rolls, recorded " << faultRolls.size() << endl;
+        ++mismatches;
+    }
+    if( states.size() != finalStates.size() )
+    {
+        cout << "Replay ended with " << states.size() << " aircraft, recorded " << finalStates.size() << endl;
+        ++mismatches;
+    }
+
+    for( size_t i = 0; i < std::min( states.size(), finalStates.size() ); ++i )
+    {
+        const AircraftState & a = states[i];
+        const AircraftState & b = finalStates[i];
+        if( a.make != b.make || a.status != b.status || a.timeFlying != b.timeFlying || a.timeWaiting != b.timeWaiting 
+            || a.timeCharging != b.timeCharging || a.numFaults != b.numFaults )
+        {
+            cout << "Aircraft " << i << " differs from recording" << endl;
+            ++mismatches;
+        }
+    }
+
+    if( summary != finalSummary )
+    {
+        cout << "Summary differs from recording" << endl;
+        ++mismatches;
+    }
+}
+
+/**
+ * @brief write the raw bytes of a value to a binary stream
+ */
+template <typename T>
+static void writeValue( std::ofstream & out, const T & value )
+{
+    out.write( reinterpret_cast<const char *>( &value ), sizeof( T ) );
+}
+
+/**
+ * @brief read the raw bytes of a value from a binary stream
+ */
+template <typename T>
+static bool readValue( std::ifstream & in, T & value )
+{
+    return static_cast<bool>( in.read( reinterpret_cast<char *>( &value ), sizeof( T ) ) );
+}
+
+bool RandomTrace::save( const string & path ) const
+{
+    std::ofstream out( path, std::ios::binary );
+    if( !out )
+        return false;
+
+    out.write( TRACE_MAGIC, 4 );
+    writeValue( out, static_cast<uint32_t>( TRACE_VERSION ) );
+
+    writeValue( out, static_cast<uint64_t>( makeDraws.size() ) );
+    out.write( reinterpret_cast<const char *>( makeDraws.data() ), makeDraws.size() );
+
+    writeValue( out, static_cast<uint64_t>( faultRolls.size() ) );
+    out.write( reinterpret_cast<const char *>( faultRolls.data() ), faultRolls.size() * sizeof( double ) );
+
+    writeValue( out, static_cast<uint64_t>( finalStates.size() ) );
+    for( const AircraftState & state : finalStates )
+    {
+        writeValue( out, static_cast<uint8_t>( state.make ) );
+        writeValue( out, static_cast<uint8_t>( state.status ) );
+        writeValue( out, state.timeFlying );
+        writeValue( out, state.timeWaiting );
+        writeValue( out, state.timeCharging );
+        writeValue( out, static_cast<int32_t>( state.numFaults ) );
+    }
+
+    writeValue( out, static_cast<uint64_t>( finalSummary.size() ) );
+    out.write( reinterpret_cast<const char *>( finalSummary.data() ), finalSummary.size() * sizeof( double ) );
+
+    return static_cast<bool>( out );
+}
+
+/**
+ * @brief determine if the rest of a stream holds enough bytes for a number of elements read from it
+ * keeps a corrupted count from allocating more than the file could ever contain
+ */
+static bool countFits( std::ifstream & in, std::streamoff fileSize, uint64_t count, size_t elementSize )
+{
+    std::streamoff remaining = fileSize - in.tellg();
+    return remaining >= 0 && count <= static_cast<uint64_t>( remaining ) / elementSize;
+}
+
+bool RandomTrace::load( const string & path )
+{
+    std::ifstream in( path, std::ios::binary | std::ios::ate );
+    if( !in )
+        return false;
+    std::streamoff fileSize = in.tellg();
+    in.seekg( 0 );
+
+    char magic[4];
+    uint32_t version;
+    if( !in.read( magic, 4 ) || memcmp( magic, TRACE_MAGIC, 4 ) != 0 || !readValue( in, version ) || version != TRACE_VERSION )
+        return false;
+
+    uint64_t count;
+    if( !readValue( in, count ) || !countFits( in, fileSize, count, sizeof( unsigned char ) ) )
+        return false;
+    makeDraws.resize( count );
+    if( !in.read( reinterpret_cast<char *>( makeDraws.data() ), count ) )
+        return false;
+
+    if( !readValue( in, count ) || !countFits( in, fileSize, count, sizeof( double ) ) )
+        return false;
+    faultRolls.resize( count );
+    if( !in.read( reinterpret_cast<char *>( faultRolls.data() ), count * sizeof( double ) ) )
+        return false;
+
+    // each state is stored as 2 bytes of make and status, 3 times and a 4 byte fault count
+    if( !readValue( in, count ) || !countFits( in, fileSize, count, 2 * sizeof( uint8_t ) + 3 * sizeof( double ) + sizeof( int32_t ) ) )
+        return false;
+    finalStates.resize( count );
+    for( AircraftState & state : finalStates )
+    {
+        uint8_t make, status;
+        int32_t numFaults;
+        if( !readValue( in, make ) || !readValue( in, status ) || !readValue( in, state.timeFlying ) || !readValue( in, state.timeWaiting ) 
+            || !readValue( in, state.timeCharging ) || !readValue( in, numFaults ) )
+            return false;
+        state.make = make;
+        state.status = status;
+        state.numFaults = numFaults;
+    }
+
+    if( !readValue( in, count ) || !countFits( in, fileSize, count, sizeof( double ) ) )
+        return false;
+    finalSummary.resize( count );
+    if( !in.read( reinterpret_cast<char *>( finalSummary.data() ), count * sizeof( double ) ) )
+        return false;
+
+    makeIdx = 0;
+    rollIdx = 0;
+    return true;
+}
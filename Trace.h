@@ -0,0 +1,82 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+enum TraceMode
+{
+    RECORD = 0,
+    REPLAY = 1
+};
+
+/**
+ * final state of a single aircraft, compared exactly between a recorded and replayed run
+ */
+struct AircraftState
+{
+    int make;
+    int status;
+    double timeFlying;
+    double timeWaiting;
+    double timeCharging;
+    int numFaults;
+};
+
+/**
+ * log of every random draw made by a simulation along with its final results, which can be saved to a binary file
+ * and fed back into another run to check that it reproduces the same results exactly
+ */
+class RandomTrace
+{
+    public:
+        /**
+         * @param mode RECORD to log draws as they are made, REPLAY to return previously loaded draws
+         */
+        RandomTrace( TraceMode mode ) : mode( mode ) {}
+
+        /**
+         * @brief pass a fleet mix draw through the trace
+         * @param drawn the make index drawn by the simulation
+         * @return the drawn value when recording, the recorded value when replaying
+         */
+        int traceMake( int drawn );
+
+        /**
+         * @brief pass a fault roll through the trace
+         * @param rolled the fault roll generated by the simulation
+         * @return the rolled value when recording, the recorded value when replaying
+         */
+        double traceFaultRoll( double rolled );
+
+        /**
+         * @brief store the final results of a recorded run, or compare them with the recorded results when replaying
+         * @param states final state of each aircraft in the order they were added
+         * @param summary the values of the summary table in row order
+         */
+        void finish( const vector<AircraftState> & states, const vector<double> & summary );
+
+        /**
+         * @brief number of differences found between the replayed and recorded run, including draws not consumed exactly
+         */
+        int getMismatches() const { return mismatches; }
+
+        TraceMode getMode() const { return mode; }
+
+        bool save( const string & path ) const;
+        bool load( const string & path );
+    private:
+        TraceMode mode;
+        vector<unsigned char> makeDraws;
+        vector<double> faultRolls;
+        vector<AircraftState> finalStates;
+        vector<double> finalSummary;
+        size_t makeIdx = 0;
+        size_t rollIdx = 0;
+        int mismatches = 0;
+};
+
+#endif
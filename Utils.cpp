@@ -1,9 +1,69 @@
 #include "Utils.h"
 #include <cmath>
+#include <map>
+#include <fstream>
+#include <string>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 #define TOLERANCE 0.00001
 
 bool almostEqual( double a, double b )
 {
     return std::abs( a - b ) < TOLERANCE;
-}
\ No newline at end of file
+}
+
+bool pinCurrentThread( int cpu )
+{
+    if( cpu == UNPINNED )
+        return true;
+
+#ifdef __linux__
+    if( cpu < 0 || cpu >= CPU_SETSIZE )
+        return false;
+
+    cpu_set_t cpus;
+    CPU_ZERO( &cpus );
+    CPU_SET( cpu, &cpus );
+    return pthread_setaffinity_np( pthread_self(), sizeof( cpus ), &cpus ) == 0;
+#else
+    return false;
+#endif
+}
+
+std::vector<std::vector<int>> getCpusBySocket()
+{
+    std::map<int, std::vector<int>> sockets;
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO( &allowed );
+    if( sched_getaffinity( 0, sizeof( allowed ), &allowed ) == 0 )
+    {
+        for( int cpu = 0; cpu < CPU_SETSIZE; ++cpu )
+        {
+            if( !CPU_ISSET( cpu, &allowed ) )
+                continue;
+
+            // cpus without topology information are treated as belonging to the first socket
+            int socket = 0;
+            std::ifstream topology( "/sys/devices/system/cpu/cpu" + std::to_string( cpu ) + "/topology/physical_package_id" );
+            if( !( topology >> socket ) || socket < 0 )
+                socket = 0;
+            sockets[socket].push_back( cpu );
+        }
+    }
+#endif
+
+    std::vector<std::vector<int>> cpusBySocket;
+    for( auto & socket : sockets )
+    {
+        if( !socket.second.empty() )
+        {
+            cpusBySocket.push_back( socket.second );
+        }
+    }
+
+    return cpusBySocket;
+}
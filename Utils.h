@@ -1,6 +1,23 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <vector>
+
+#define UNPINNED -1
+
 bool almostEqual( double a, double b );
 
-#endif
\ No newline at end of file
+/**
+ * @brief restrict the calling thread to run only on a single cpu
+ * @param cpu index of the cpu to pin to, UNPINNED leaves the thread unchanged
+ * @return true if the thread was pinned or left unpinned as requested
+ */
+bool pinCurrentThread( int cpu );
+
+/**
+ * @brief get the cpus this process may run on grouped by the socket they belong to
+ * @return a non empty list of cpus per socket, or no sockets if the cpus could not be determined
+ */
+std::vector<std::vector<int>> getCpusBySocket();
+
+#endif
@@ -1,14 +1,197 @@
 #include "Simulation.h"
+#include "Replication.h"
 #include <string>
 #include <iostream>
+#include <cstring>
+#include <climits>
+
+/**
+ * @brief find the summary metric matching a short name ( flight, wait, charge, faults, miles )
+ * @return true if a metric matched the name
+ */
+bool parseMetric( const char * name, SummaryMetric & metric )
+{
+    const char * names[] = { "flight", "wait", "charge", "faults", "miles" };
+    for( int i = 0; i < 5; ++i )
+    {
+        if( strcasecmp( name, names[i] ) == 0 )
+        {
+            metric = static_cast<SummaryMetric>( i );
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief read a count of replications, which must be a whole number of at least 1
+ * @return true if a valid count was read
+ */
+bool parseCount( const char * text, int & count )
+{
+    char * end = nullptr;
+    long value = strtol( text, &end, 10 );
+    if( end == text || *end != '\0' || value < 1 || value > INT_MAX )
+        return false;
+    count = value;
+    return true;
+}
+
+/**
+ * @brief read a relative confidence interval half-width, which must be a number greater than 0
+ * @return true if a valid width was read
+ */
+bool parseWidth( const char * text, double & width )
+{
+    char * end = nullptr;
+    width = strtod( text, &end );
+    return end != text && *end == '\0' && width > 0.0;
+}
+
+/**
+ * @brief read the cpus for the timer, flying, charging and waiting threads from a comma separated list
+ * @return true if all 4 cpus were read
+ */
+bool parsePlacement( const char * list, ThreadPlacement & placement )
+{
+    int * cpus[] = { &placement.timerCpu, &placement.flyingCpu, &placement.chargingCpu, &placement.waitingCpu };
+    for( int i = 0; i < 4; ++i )
+    {
+        char * end = nullptr;
+        *cpus[i] = strtol( list, &end, 10 );
+        if( end == list || *end != ( i < 3 ? ',' : '\0' ) )
+            return false;
+        list = end + 1;
+    }
+    return true;
+}
+
+void printUsage( const char * program )
+{
+    cout << "usage: " << program << " [-a <timer>,<flying>,<charging>,<waiting>] [-s <scenario file>] [-r <trace file> | -p <trace file>] [-t <metric> <make> <relative half width>]... [-b <batch size>] [-m <max replications>] [-n]" << endl;
+    cout << "  -a  pin the timer and queue threads of a single run to the given cpus, -1 leaves a thread unpinned, not valid with -t" << endl;
+    cout << "  -s  schedule aircraft arrivals and departures and charger outages from a scenario file" << endl;
+    cout << "  -r  record every random draw and the final results of a single run to a trace file, not valid with -t" << endl;
+    cout << "  -p  replay the random draws of a trace file and compare the final results exactly with the recording, not valid with -t" << endl;
+    cout << "  -t  replicate until the 95% confidence interval of the metric ( flight, wait, charge, faults, miles )" << endl;
+    cout << "      for the make is within the given fraction of its mean, may be repeated" << endl;
+    cout << "  -b  number of replications to run in parallel per batch" << endl;
+    cout << "  -m  maximum number of replications to run" << endl;
+    cout << "  -n  place each replication's threads and memory on a single socket, requires -t" << endl;
+}
 
 int main( int argc, char ** argv )
 {
     srand( 0 );
 
-    SimulationEngine sim;
-    sim.init();
-    sim.run();
+    vector<ReplicationTarget> targets;
+    int batchSize = std::max( 1u, thread::hardware_concurrency() / 4 );
+    int maxReplications = MAX_REPLICATIONS;
+    ThreadPlacement placement;
+    bool threadPlacement = false;
+    bool socketPlacement = false;
+    const char * recordPath = nullptr;
+    const char * replayPath = nullptr;
+    EventCalendar calendar;
+    for( int i = 1; i < argc; ++i )
+    {
+        ReplicationTarget target;
+        if( strcmp( argv[i], "-t" ) == 0 && i + 3 < argc && parseMetric( argv[i + 1], target.metric ) && parseMake( argv[i + 2], target.make ) 
+            && parseWidth( argv[i + 3], target.relativeHalfWidth ) )
+        {
+            targets.push_back( target );
+            i += 3;
+        }
+        else if( strcmp( argv[i], "-a" ) == 0 && i + 1 < argc && parsePlacement( argv[i + 1], placement ) )
+        {
+            threadPlacement = true;
+            ++i;
+        }
+        else if( strcmp( argv[i], "-s" ) == 0 && i + 1 < argc )
+        {
+            if( !calendar.load( argv[++i] ) )
+            {
+                std::cerr << "could not load scenario " << argv[i] << ": " << calendar.getLoadError() << endl;
+                return 1;
+            }
+        }
+        else if( strcmp( argv[i], "-r" ) == 0 && i + 1 < argc )
+        {
+            recordPath = argv[++i];
+        }
+        else if( strcmp( argv[i], "-p" ) == 0 && i + 1 < argc )
+        {
+            replayPath = argv[++i];
+        }
+        else if( strcmp( argv[i], "-n" ) == 0 )
+        {
+            socketPlacement = true;
+        }
+        else if( strcmp( argv[i], "-b" ) == 0 && i + 1 < argc && parseCount( argv[i + 1], batchSize ) )
+        {
+            ++i;
+        }
+        else if( strcmp( argv[i], "-m" ) == 0 && i + 1 < argc && parseCount( argv[i + 1], maxReplications ) )
+        {
+            ++i;
+        }
+        else
+        {
+            printUsage( argv[0] );
+            return 1;
+        }
+    }
+
+    // -a, -r and -p only apply to a single run, -n only to replications, and a run either records or replays
+    if( ( threadPlacement && !targets.empty() ) || ( socketPlacement && targets.empty() ) 
+        || ( ( recordPath || replayPath ) && !targets.empty() ) || ( recordPath && replayPath ) )
+    {
+        printUsage( argv[0] );
+        return 1;
+    }
+
+    if( targets.empty() )
+    {
+        RandomTrace trace( replayPath ? REPLAY : RECORD );
+        if( replayPath && !trace.load( replayPath ) )
+        {
+            std::cerr << "could not load trace " << replayPath << endl;
+            return 1;
+        }
+
+        SimulationEngine sim;
+        sim.setThreadPlacement( placement );
+        sim.setScenario( calendar );
+        if( recordPath || replayPath )
+        {
+            sim.setTrace( &trace );
+        }
+        sim.init();
+        sim.run();
+
+        if( recordPath && !trace.save( recordPath ) )
+        {
+            std::cerr << "could not save trace " << recordPath << endl;
+            return 1;
+        }
+        if( replayPath )
+        {
+            cout << "Replay " << ( trace.getMismatches() == 0 ? "matched recording" : "differed from recording" ) << endl;
+            return trace.getMismatches() == 0 ? 0 : 1;
+        }
+    }
+    else
+    {
+        ReplicationRunner runner( rand(), batchSize, maxReplications );
+        runner.setSocketPlacement( socketPlacement );
+        runner.setScenario( calendar );
+        for( const ReplicationTarget & target : targets )
+        {
+            runner.addTarget( target.metric, target.make, target.relativeHalfWidth );
+        }
+        runner.run();
+        runner.displayResults();
+    }
 
     return 0;
-}
\ No newline at end of file
+}
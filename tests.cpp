@@ -1,5 +1,12 @@
 #include "Models.h"
+#include "Simulation.h"
+#include "Replication.h"
+#include "Metrics.h"
 #include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <cstdint>
 #include "Utils.h"
 
 using std::cout;
@@ -67,10 +74,267 @@ int main()
     assert( testCraft2.getNumFaults() == 2 );
     cout << "  Passed: expected resulting values for other make" << endl;
 
+    cout << "Testing record and replay of a whole simulation" << endl;
+    const char * tracePath = "test_trace.bin";
+    RandomTrace recording( RECORD );
+    SimulationEngine recordedSim( 1 );
+    recordedSim.setRealTime( false );
+    recordedSim.setTrace( &recording );
+    recordedSim.init();
+    recordedSim.run( false );
+    bool saved = recording.save( tracePath );
+    assert( saved );
+    cout << "  Passed: recording saved" << endl;
+
+    // a differently seeded engine should reproduce the recording exactly when fed the recorded draws
+    RandomTrace replay( REPLAY );
+    bool loaded = replay.load( tracePath );
+    assert( loaded );
+    SimulationEngine replayedSim( 2 );
+    replayedSim.setRealTime( false );
+    replayedSim.setTrace( &replay );
+    replayedSim.init();
+    replayedSim.run( false );
+    assert( replay.getMismatches() == 0 );
+    cout << "  Passed: replay matches recording" << endl;
+
+    // an engine that changes the results should be caught
+    RandomTrace changedReplay( REPLAY );
+    loaded = changedReplay.load( tracePath );
+    assert( loaded );
+    SimulationEngine changedSim( 1 );
+    changedSim.setRealTime( false );
+    changedSim.setTrace( &changedReplay );
+    changedSim.init();
+    changedSim.addNewVTOL( ECHO );
+    changedSim.run( false );
+    assert( changedReplay.getMismatches() > 0 );
+    cout << "  Passed: replay detects changed results" << endl;
+
+    // a corrupted count larger than the file should fail to load rather than try to allocate it
+    std::fstream corrupted( tracePath, std::ios::binary | std::ios::in | std::ios::out );
+    uint64_t hugeCount = 1ULL << 60;
+    corrupted.seekp( 8 ); // after the magic and version
+    corrupted.write( reinterpret_cast<const char *>( &hugeCount ), sizeof( hugeCount ) );
+    corrupted.close();
+    RandomTrace corruptedReplay( REPLAY );
+    loaded = corruptedReplay.load( tracePath );
+    assert( !loaded );
+    cout << "  Passed: corrupted trace rejected" << endl;
+    std::remove( tracePath );
+
+    cout << "Testing scheduled scenario events" << endl;
+    EventCalendar calendar;
+    calendar.schedule( { 1.0, CHARGER_OFFLINE, ALPHA, 1 } );
+    calendar.schedule( { 0.5, AIRCRAFT_DEPARTURE, ALPHA, 1 } );
+    calendar.schedule( { 1.0, CHARGER_ONLINE, ALPHA, 1 } );
+    assert( !calendar.hasDueEvent( 0.4 ) );
+    assert( calendar.hasDueEvent( 0.5 ) && calendar.popEvent().type == AIRCRAFT_DEPARTURE );
+    assert( calendar.popEvent().type == CHARGER_OFFLINE ); // events at the same time stay in the order scheduled
+    assert( calendar.popEvent().type == CHARGER_ONLINE );
+    assert( !calendar.hasDueEvent( 10.0 ) );
+    cout << "  Passed: events consumed in time order" << endl;
+
+    const char * scenarioPath = "test_scenario.txt";
+    std::ofstream scenarioFile( scenarioPath );
+    scenarioFile << "# unsorted on purpose\nfleet 4\n2.0 charger_online 1\n0.5 arrive Beta 2\n1.0 depart echo 1\n";
+    scenarioFile.close();
+    EventCalendar loadedCalendar;
+    bool scenarioLoaded = loadedCalendar.load( scenarioPath );
+    assert( scenarioLoaded );
+    assert( loadedCalendar.getInitialFleet() == 4 );
+    const ScenarioEvent & firstEvent = loadedCalendar.popEvent();
+    assert( firstEvent.type == AIRCRAFT_ARRIVAL && firstEvent.make == BETA && firstEvent.count == 2 );
+    assert( loadedCalendar.popEvent().type == AIRCRAFT_DEPARTURE );
+    assert( loadedCalendar.popEvent().type == CHARGER_ONLINE );
+    cout << "  Passed: unsorted scenario file loaded in time order" << endl;
+
+    scenarioFile.open( scenarioPath );
+    scenarioFile << "fleet 4\n0.5 arrive gamma 1\n";
+    scenarioFile.close();
+    EventCalendar badCalendar;
+    scenarioLoaded = badCalendar.load( scenarioPath );
+    assert( !scenarioLoaded );
+    assert( badCalendar.getLoadError().find( "line 2" ) != string::npos );
+
+    scenarioFile.open( scenarioPath );
+    scenarioFile << "0.03 arrive echo 2 junk\n";
+    scenarioFile.close();
+    EventCalendar extraCalendar;
+    scenarioLoaded = extraCalendar.load( scenarioPath );
+    assert( !scenarioLoaded );
+    assert( extraCalendar.getLoadError().find( "unexpected text after count" ) != string::npos );
+    std::remove( scenarioPath );
+    cout << "  Passed: scenario errors report their line" << endl;
+
+    // a single alpha arriving at the start and leaving after half an hour should only fly for that half hour
+    EventCalendar departure;
+    departure.setInitialFleet( 0 );
+    departure.schedule( { 0.0, AIRCRAFT_ARRIVAL, ALPHA, 1 } );
+    departure.schedule( { 0.5, AIRCRAFT_DEPARTURE, ALPHA, 1 } );
+    SimulationEngine departureSim( 1 );
+    departureSim.setRealTime( false );
+    departureSim.setScenario( departure );
+    departureSim.init();
+    departureSim.run( false );
+    MakeSummary alphaSummary = departureSim.getMakeSummary( ALPHA );
+    assert( alphaSummary.count == 1 );
+    assert( std::abs( alphaSummary.avgFlightTime - 0.5 ) < 0.001 );
+    assert( departureSim.getMakeSummary( BETA ).count == 0 );
+    cout << "  Passed: scheduled arrival and departure" << endl;
+
+    // a departure due in the same tick as an arrival of the same make cancels that arrival rather than an older aircraft
+    EventCalendar sameTick;
+    sameTick.setInitialFleet( 0 );
+    sameTick.schedule( { 0.0, AIRCRAFT_ARRIVAL, ALPHA, 1 } );
+    sameTick.schedule( { 1.0, AIRCRAFT_ARRIVAL, ALPHA, 2 } );
+    sameTick.schedule( { 1.0, AIRCRAFT_DEPARTURE, ALPHA, 1 } );
+    SimulationEngine sameTickSim( 1 );
+    sameTickSim.setRealTime( false );
+    sameTickSim.setScenario( sameTick );
+    sameTickSim.init();
+    sameTickSim.run( false );
+    alphaSummary = sameTickSim.getMakeSummary( ALPHA );
+    assert( alphaSummary.count == 2 );
+    // the first alpha keeps flying, for 5/3 hours then 11/15 after charging, and the remaining arrival drains its 5/3 hours
+    assert( std::abs( alphaSummary.avgFlightTime - ( 5.0 / 3.0 + 11.0 / 15.0 + 5.0 / 3.0 ) / 2 ) < 0.001 );
+    cout << "  Passed: departure cancels an arrival due the same tick" << endl;
+
+    // with every charger out of service no aircraft should ever charge
+    EventCalendar outage;
+    outage.setInitialFleet( 0 );
+    outage.schedule( { 0.0, AIRCRAFT_ARRIVAL, BETA, 2 } );
+    outage.schedule( { 0.0, CHARGER_OFFLINE, ALPHA, NUM_CHARGERS } );
+    SimulationEngine outageSim( 1 );
+    outageSim.setRealTime( false );
+    outageSim.setScenario( outage );
+    outageSim.init();
+    outageSim.run( false );
+    assert( outageSim.getMakeSummary( BETA ).count == 2 );
+    assert( almostEqual( outageSim.getMakeSummary( BETA ).avgChargeTime, 0 ) );
+    assert( almostEqual( outageSim.getMetrics().getChargerUtilization( 0 ), 0 ) );
+    cout << "  Passed: charger outage" << endl;
+
+    // 10 alpha run out of charge together and queue for 3 chargers, 9 reach a charger before the end and 1 is still waiting
+    EventCalendar saturated;
+    saturated.setInitialFleet( 0 );
+    saturated.schedule( { 0.0, AIRCRAFT_ARRIVAL, ALPHA, 10 } );
+    SimulationEngine saturatedSim( 1 );
+    saturatedSim.setRealTime( false );
+    saturatedSim.setScenario( saturated );
+    saturatedSim.init();
+    saturatedSim.run( false );
+    const SimulationMetrics & saturatedMetrics = saturatedSim.getMetrics();
+    long long reachedCharger = 0;
+    long long stillWaiting = 0;
+    for( int i = 0; i < saturatedMetrics.getNumWaitBins(); ++i )
+    {
+        reachedCharger += saturatedMetrics.getTimeToChargerCount( i );
+        stillWaiting += saturatedMetrics.getUnfinishedWaitCount( i );
+    }
+    assert( reachedCharger == 9 );
+    assert( stillWaiting == 1 );
+    cout << "  Passed: every wait counted when chargers are saturated" << endl;
+
+    // with no chargers every wait is unfinished, whether cut short by leaving service or by the end of the run
+    EventCalendar noChargers;
+    noChargers.setInitialFleet( 0 );
+    noChargers.schedule( { 0.0, AIRCRAFT_ARRIVAL, BETA, 3 } );
+    noChargers.schedule( { 0.0, CHARGER_OFFLINE, ALPHA, NUM_CHARGERS } );
+    noChargers.schedule( { 2.0, AIRCRAFT_DEPARTURE, BETA, 1 } );
+    SimulationEngine noChargerSim( 1 );
+    noChargerSim.setRealTime( false );
+    noChargerSim.setScenario( noChargers );
+    noChargerSim.init();
+    noChargerSim.run( false );
+    stillWaiting = 0;
+    for( int i = 0; i < noChargerSim.getMetrics().getNumWaitBins(); ++i )
+    {
+        assert( noChargerSim.getMetrics().getTimeToChargerCount( i ) == 0 );
+        stillWaiting += noChargerSim.getMetrics().getUnfinishedWaitCount( i );
+    }
+    assert( stillWaiting == 3 );
+    cout << "  Passed: departures and the end of the run count as unfinished waits" << endl;
+
+    cout << "Testing time bucketed metrics" << endl;
+    // 2 buckets of 2 half hour ticks, queue sizes above 3 counted together and 3 one hour time to charger bins
+    SimulationMetrics metrics( 2, 2, 0.5, 3, 3, 1.0 );
+    metrics.recordTick( 0.5, 1, 2 );
+    metrics.recordTick( 0.25, 1, 4 );
+    metrics.recordTick( 1.0, 2, 0 );
+    metrics.recordTick( 0.0, 2, 1 );
+    metrics.recordTick( 1.0, 2, 5 ); // past the expected duration so counted in the last bucket
+    assert( almostEqual( metrics.getChargerUtilization( 0 ), 0.75 ) );
+    assert( almostEqual( metrics.getMeanWaitingQueue( 0 ), 3.0 ) );
+    assert( metrics.getMaxWaitingQueue( 0 ) == 4 );
+    assert( almostEqual( metrics.getChargerUtilization( 1 ), 2.0 / 3.0 ) );
+    assert( almostEqual( metrics.getMeanWaitingQueue( 1 ), 2.0 ) );
+    assert( metrics.getMaxWaitingQueue( 1 ) == 5 );
+    cout << "  Passed: per bucket utilization and queue sizes" << endl;
+
+    assert( metrics.getWaitingQueueCount( 0 ) == 1 );
+    assert( metrics.getWaitingQueueCount( 1 ) == 1 );
+    assert( metrics.getWaitingQueueCount( 2 ) == 1 );
+    assert( metrics.getWaitingQueueCount( 3 ) == 2 ); // sizes 4 and 5 are counted as 3+
+    metrics.recordTimeToCharger( 0.5 );
+    metrics.recordTimeToCharger( 1.5 );
+    metrics.recordTimeToCharger( 2.5 );
+    metrics.recordTimeToCharger( 10.0 ); // longer than the last bin so counted in it
+    assert( metrics.getTimeToChargerCount( 0 ) == 1 );
+    assert( metrics.getTimeToChargerCount( 1 ) == 1 );
+    assert( metrics.getTimeToChargerCount( 2 ) == 2 );
+    metrics.recordUnfinishedWait( 0.5 );
+    metrics.recordUnfinishedWait( 10.0 );
+    assert( metrics.getUnfinishedWaitCount( 0 ) == 1 );
+    assert( metrics.getUnfinishedWaitCount( 2 ) == 1 );
+    assert( metrics.getTimeToChargerCount( 0 ) == 1 ); // unfinished waits are kept apart from completed ones
+    cout << "  Passed: queue size and time to charger histograms" << endl;
+
+    cout << "Testing replication placement" << endl;
+    vector<vector<int>> cpusBySocket = { { 0, 1, 2, 3, 4, 5, 6, 7 }, { 8, 9, 10, 11, 12, 13 } };
+    ThreadPlacement placement = ReplicationRunner::getPlacement( cpusBySocket, 0 );
+    assert( placement.timerCpu == 0 && placement.flyingCpu == 1 && placement.chargingCpu == 2 && placement.waitingCpu == 3 );
+    placement = ReplicationRunner::getPlacement( cpusBySocket, 1 ); // second replication goes to the second socket
+    assert( placement.timerCpu == 8 && placement.flyingCpu == 9 && placement.chargingCpu == 10 && placement.waitingCpu == 11 );
+    placement = ReplicationRunner::getPlacement( cpusBySocket, 2 ); // third takes the next 4 cpus of the first socket
+    assert( placement.timerCpu == 4 && placement.flyingCpu == 5 && placement.chargingCpu == 6 && placement.waitingCpu == 7 );
+    placement = ReplicationRunner::getPlacement( cpusBySocket, 3 ); // only 2 cpus left on the second socket
+    assert( placement.timerCpu == UNPINNED && placement.flyingCpu == UNPINNED && placement.chargingCpu == UNPINNED && placement.waitingCpu == UNPINNED );
+    placement = ReplicationRunner::getPlacement( cpusBySocket, 4 ); // first socket is full
+    assert( placement.timerCpu == UNPINNED );
+    placement = ReplicationRunner::getPlacement( vector<vector<int>>(), 0 );
+    assert( placement.timerCpu == UNPINNED && placement.waitingCpu == UNPINNED );
+    cout << "  Passed: replications dealt to sockets without sharing cpus" << endl;
+
+    cout << "Testing replication confidence intervals" << endl;
+    assert( almostEqual( ReplicationRunner::getMean( { 1.0, 3.0 } ), 2.0 ) );
+    assert( almostEqual( ReplicationRunner::getHalfWidth( { 1.0, 3.0 } ), 12.706 ) ); // 1 degree of freedom, standard error of 1
+    vector<double> sample;
+    for( int i = 0; i < 31; ++i )
+    {
+        sample.push_back( i );
+    }
+    // the sample variance of 0 through n - 1 is n * ( n + 1 ) / 12
+    assert( almostEqual( ReplicationRunner::getHalfWidth( sample ), 2.042 * std::sqrt( 31.0 * 32 / 12 / 31 ) ) ); // last t value at 30 degrees of freedom
+    sample.push_back( 31 );
+    assert( almostEqual( ReplicationRunner::getHalfWidth( sample ), 1.960 * std::sqrt( 32.0 * 33 / 12 / 32 ) ) ); // z value past the t table
+    cout << "  Passed: half widths at and past the end of the t table" << endl;
+
+    ReplicationRunner zeroMean( 0, 1 );
+    zeroMean.addTarget( AVG_WAIT_TIME, ALPHA, 0.1 );
+    zeroMean.addObservation( 0, 0.0 );
+    assert( !zeroMean.targetsMet() ); // a single observation has no confidence interval
+    zeroMean.addObservation( 0, 0.0 );
+    assert( zeroMean.targetsMet() );
+    zeroMean.addObservation( 0, -1.0 );
+    zeroMean.addObservation( 0, 1.0 );
+    assert( !zeroMean.targetsMet() ); // a zero mean is only met with no spread
+    cout << "  Passed: zero mean targets" << endl;
+
     // additional tests ensuring the behaviors of other makes could potentially be beneficial
 
-    // creating unit tests for the simulation could be done by adding get functions for the resulting averages and loading the simulation with specific combinations
-    // of aircraft and comparing the resulting averages with the expected values from that combination of aircrafts
+    // further unit tests for the simulation could be done by loading the simulation with specific combinations of aircraft
+    // and comparing the resulting averages from getMakeSummary with the expected values from that combination of aircrafts
     // e.g. loading with 6 alpha should result in 2.1 avg flight time, 0.3 avg wait time, .6 average charge time, 6048 passenger miles, and a variable amount of max faults
     return 0;
 }
\ No newline at end of file